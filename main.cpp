@@ -29,6 +29,19 @@ void run_demo() {
     book.add_order(Side::SELL, OrderType::LIMIT, 149.00, 150);
     book.print_book();
     
+    std::cout << "demo 4: good-till-date and mass cancel\n";
+    auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::high_resolution_clock::now().time_since_epoch());
+    book.add_order(Side::BUY, OrderType::LIMIT, 148.00, 50, AccountId{7}, SessionId{1},
+                   TimeInForce::GTD, now + std::chrono::milliseconds(50));
+    book.add_order(Side::SELL, OrderType::LIMIT, 152.00, 75, AccountId{7}, SessionId{1});
+    book.add_order(Side::SELL, OrderType::LIMIT, 152.50, 25, AccountId{7}, SessionId{2});
+    book.print_book();
+    std::cout << "expired orders: " << book.expire_orders(now + std::chrono::milliseconds(100)) << "\n";
+    std::cout << "cancelled for session 1: " << book.mass_cancel(SessionId{1}) << "\n";
+    std::cout << "cancelled for account 7: " << book.mass_cancel(AccountId{7}) << "\n";
+    book.print_book();
+    
     std::cout << "\n********** statistics **********\n";
     std::cout << "total orders processed: " << book.get_total_orders() << "\n";
     std::cout << "total trades executed: " << book.get_total_trades() << "\n";
@@ -132,12 +145,64 @@ void run_benchmark_large() {
     std::cout << "max Latency: " << book.get_max_latency_ns() << " ns\n";
 }
 
+void run_benchmark_mass_cancel() {
+    std::cout << "\n****************************************\n";
+    std::cout << "   benchmark 3 (100k quote expiry / mass cancel)\n";
+    std::cout << "****************************************\n\n";
+    
+    const int NUM_ORDERS = 100000;
+    const AccountId ACCOUNT{42};
+    const SessionId SESSION{1};
+    
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> tick_dist(1, 500);
+    std::uniform_int_distribution<> qty_dist(10, 1000);
+    
+    // non-crossing quotes so every order rests: bids below 100, asks above
+    auto load = [&](OrderBook& book, TimeInForce tif, std::chrono::nanoseconds expire) {
+        for (int i = 0; i < NUM_ORDERS; ++i) {
+            Side side = (i % 2 == 0) ? Side::BUY : Side::SELL;
+            double offset = tick_dist(gen) / 100.0;
+            double price = (side == Side::BUY) ? 100.0 - offset : 100.0 + offset;
+            book.add_order(side, OrderType::LIMIT, price, qty_dist(gen), ACCOUNT, SESSION, tif, expire);
+        }
+    };
+    
+    auto report = [](const char* label, auto&& action) {
+        auto start = std::chrono::high_resolution_clock::now();
+        size_t count = action();
+        auto end = std::chrono::high_resolution_clock::now();
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+        std::cout << label << ": " << count << " orders in " << us.count() << " μs\n";
+    };
+    
+    OrderBook account_book("THREE");
+    load(account_book, TimeInForce::GTC, std::chrono::nanoseconds::zero());
+    report("account mass cancel", [&] { return account_book.mass_cancel(ACCOUNT); });
+    
+    OrderBook session_book("THREE");
+    load(session_book, TimeInForce::GTC, std::chrono::nanoseconds::zero());
+    report("session mass cancel (disconnect)", [&] { return session_book.mass_cancel(SESSION); });
+    
+    OrderBook all_book("THREE");
+    load(all_book, TimeInForce::GTC, std::chrono::nanoseconds::zero());
+    report("cancel all", [&] { return all_book.mass_cancel(); });
+    
+    OrderBook expiry_book("FOUR");
+    auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::high_resolution_clock::now().time_since_epoch());
+    load(expiry_book, TimeInForce::GTD, now + std::chrono::seconds(30));
+    report("expiry", [&] { return expiry_book.expire_orders(now + std::chrono::seconds(31)); });
+}
+
 int main() {
     std::cout << "\n* ORDER BOOK MATCHING ENGINE * :)\n\n";
     
     run_demo();
     run_benchmark_small();
     run_benchmark_large();
+    run_benchmark_mass_cancel();
     
     std::cout << "\n****************************************\n";
     std::cout << "  benchmark complete!\n";
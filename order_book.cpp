@@ -40,28 +40,242 @@ void OrderPool::clear() {
     next_order_in_chunk_ = 0;
 }
 
+OrderIndex::OrderIndex()
+    : entries_(INITIAL_CAPACITY, Entry{0, nullptr}), mask_(INITIAL_CAPACITY - 1), size_(0) {}
+
+// robin hood placement: an entry never sits further from its home than the
+// entries it passed, which lets find and erase stop at the end of its run
+void OrderIndex::place(Entry entry) {
+    size_t i = entry.id & mask_;
+    size_t distance = 0;
+    
+    while (entries_[i].id != 0) {
+        size_t existing = (i - (entries_[i].id & mask_)) & mask_;
+        if (existing < distance) {
+            std::swap(entry, entries_[i]);
+            distance = existing;
+        }
+        i = (i + 1) & mask_;
+        ++distance;
+    }
+    entries_[i] = entry;
+}
+
+void OrderIndex::grow() {
+    std::vector<Entry> old(entries_.size() * 2, Entry{0, nullptr});
+    old.swap(entries_);
+    mask_ = entries_.size() - 1;
+    
+    for (const Entry& entry : old) {
+        if (entry.id != 0) place(entry);
+    }
+}
+
+void OrderIndex::insert(Order* order) {
+    if ((size_ + 1) * 2 > entries_.size()) grow();
+    
+    place(Entry{order->id, order});
+    ++size_;
+}
+
+size_t OrderIndex::locate(uint64_t id) const {
+    size_t i = id & mask_;
+    for (size_t distance = 0; ; ++distance, i = (i + 1) & mask_) {
+        const Entry& entry = entries_[i];
+        if (entry.id == id) return i;
+        if (entry.id == 0 || ((i - (entry.id & mask_)) & mask_) < distance) return NOT_FOUND;
+    }
+}
+
+Order* OrderIndex::find(uint64_t id) const {
+    size_t i = locate(id);
+    return i == NOT_FOUND ? nullptr : entries_[i].order;
+}
+
+void OrderIndex::erase(uint64_t id) {
+    size_t i = locate(id);
+    if (i == NOT_FOUND) return;
+    
+    // shift the rest of the run back by one, stopping at an entry already home
+    for (size_t j = (i + 1) & mask_;
+         entries_[j].id != 0 && (entries_[j].id & mask_) != j;
+         j = (j + 1) & mask_) {
+        entries_[i] = entries_[j];
+        i = j;
+    }
+    
+    entries_[i] = Entry{0, nullptr};
+    --size_;
+}
+
+void OrderIndex::clear() {
+    std::fill(entries_.begin(), entries_.end(), Entry{0, nullptr});
+    size_ = 0;
+}
+
+TimerWheel::TimerWheel(uint64_t start_tick) : current_tick_(start_tick), size_(0) {
+    slots_.fill(nullptr);
+    occupied_.fill(0);
+}
+
+void TimerWheel::place(Order* order) {
+    uint64_t delta = order->expire_tick > current_tick_ ? order->expire_tick - current_tick_ : 0;
+    uint64_t tick = order->expire_tick;
+    
+    // beyond the wheel's horizon: park in the furthest slot, cascade re-places it
+    if (delta > MAX_DELTA) {
+        delta = MAX_DELTA;
+        tick = current_tick_ + MAX_DELTA;
+    }
+    
+    uint32_t level = 0;
+    while (level + 1 < LEVELS && delta >= (1ull << (SLOT_BITS * (level + 1)))) {
+        ++level;
+    }
+    
+    uint32_t slot = level * SLOTS + ((tick >> (SLOT_BITS * level)) & SLOT_MASK);
+    Order*& head = slots_[slot];
+    
+    order->timer_slot = slot;
+    order->timer_prev = nullptr;
+    order->timer_next = head;
+    if (head) head->timer_prev = order;
+    head = order;
+    occupied_[slot / 64] |= 1ull << (slot % 64);
+}
+
+Order* TimerWheel::take_slot(uint32_t slot) {
+    Order* order = slots_[slot];
+    slots_[slot] = nullptr;
+    occupied_[slot / 64] &= ~(1ull << (slot % 64));
+    return order;
+}
+
+// earliest tick after current_tick_ at which an occupied slot expires (level 0)
+// or cascades (higher levels), UINT64_MAX when the wheel is empty
+uint64_t TimerWheel::next_event_tick() const {
+    if (size_ == 0) return UINT64_MAX;
+    
+    uint64_t next = UINT64_MAX;
+    for (uint32_t level = 0; level < LEVELS; ++level) {
+        const uint64_t* words = &occupied_[level * WORDS];
+        uint64_t base = current_tick_ >> (SLOT_BITS * level);
+        uint32_t index = base & SLOT_MASK;
+        uint32_t start = (index + 1) & SLOT_MASK;
+        
+        // scan the ring from the slot after index, wrapping back round to it
+        for (uint32_t n = 0; n <= WORDS; ++n) {
+            uint32_t word = ((start / 64) + n) % WORDS;
+            uint64_t bits = words[word];
+            if (n == 0) {
+                bits &= ~0ull << (start % 64);
+            } else if (n == WORDS) {
+                bits &= (1ull << (start % 64)) - 1;
+            }
+            if (bits) {
+                uint32_t slot = word * 64 + __builtin_ctzll(bits);
+                uint64_t distance = ((slot - index - 1) & SLOT_MASK) + 1;
+                next = std::min(next, (base + distance) << (SLOT_BITS * level));
+                break;
+            }
+        }
+    }
+    return next;
+}
+
+void TimerWheel::cascade(uint32_t level) {
+    Order* order = take_slot(level * SLOTS + ((current_tick_ >> (SLOT_BITS * level)) & SLOT_MASK));
+    
+    while (order) {
+        Order* next = order->timer_next;
+        place(order);
+        order = next;
+    }
+}
+
+void TimerWheel::schedule(Order* order) {
+    place(order);
+    ++size_;
+}
+
+void TimerWheel::cancel(Order* order) {
+    if (order->timer_slot == NO_SLOT) return;
+    
+    if (order->timer_prev) {
+        order->timer_prev->timer_next = order->timer_next;
+    } else {
+        slots_[order->timer_slot] = order->timer_next;
+        if (!order->timer_next) {
+            occupied_[order->timer_slot / 64] &= ~(1ull << (order->timer_slot % 64));
+        }
+    }
+    if (order->timer_next) {
+        order->timer_next->timer_prev = order->timer_prev;
+    }
+    
+    order->timer_prev = nullptr;
+    order->timer_next = nullptr;
+    order->timer_slot = NO_SLOT;
+    --size_;
+}
+
+void TimerWheel::clear() {
+    slots_.fill(nullptr);
+    occupied_.fill(0);
+    size_ = 0;
+}
+
 OrderBook::OrderBook(const std::string& symbol)
-    : symbol_(symbol), total_orders_processed_(0), total_trades_(0), 
+    : symbol_(symbol),
+      timer_wheel_(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::high_resolution_clock::now().time_since_epoch()).count() / TIMER_TICK_NS),
+      day_orders_(nullptr), session_close_(0), session_close_tick_(0),
+      total_orders_processed_(0), total_trades_(0), 
       total_latency_ns_(0), min_latency_ns_(UINT64_MAX), 
       max_latency_ns_(0), order_id_counter_(1) {
     trades_.reserve(1000000);
 }
 
 OrderBook::~OrderBook() {
-    for (auto& [id, order] : orders_) {
+    orders_.for_each([this](Order* order) {
         pool_.deallocate(order);
-    }
+    });
 }
 
-uint64_t OrderBook::add_order(Side side, OrderType type, double price, uint64_t quantity) {
+uint64_t OrderBook::add_order(Side side, OrderType type, double price, uint64_t quantity,
+                              AccountId account, SessionId session, TimeInForce tif,
+                              std::chrono::nanoseconds expire_time) {
     auto start = std::chrono::high_resolution_clock::now();
     
+    // the wheel only moves in expire_orders, so expiry is also checked
+    // against the clock; a time the wheel has passed cannot be scheduled
+    auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch());
+    
+    // a DAY order needs a session close to expire at
+    if (tif == TimeInForce::DAY &&
+        (session_close_tick_ == 0 || session_close_ <= now ||
+         session_close_tick_ <= timer_wheel_.current_tick())) {
+        return 0;
+    }
+    
+    // a GTD order without a date is invalid
+    if (tif == TimeInForce::GTD && expire_time.count() <= 0) return 0;
+    
+    // round up so an order never expires before its requested time
+    uint64_t expire_tick = 0;
+    if (tif == TimeInForce::GTD) {
+        expire_tick = (static_cast<uint64_t>(expire_time.count()) + TIMER_TICK_NS - 1) / TIMER_TICK_NS;
+        if (expire_time <= now || expire_tick <= timer_wheel_.current_tick()) return 0;
+    }
+    
     uint64_t order_id = order_id_counter_.fetch_add(1);
     
     Order* order = pool_.allocate();
-    new (order) Order(order_id, symbol_, side, type, price, quantity);
+    new (order) Order(order_id, side, type, price, quantity,
+                      account.value, session.value, tif);
+    order->expire_tick = expire_tick;
     
-    orders_[order_id] = order;
+    orders_.insert(order);
     
     match_order(order);
     
@@ -105,8 +319,7 @@ void OrderBook::match_market_order(Order* order) {
                 
                 if (opposing_order->filled_quantity == opposing_order->quantity) {
                     level->remove_front();
-                    orders_.erase(opposing_order->id);
-                    pool_.deallocate(opposing_order);
+                    release_order(opposing_order);
                 }
             }
             
@@ -133,8 +346,7 @@ void OrderBook::match_market_order(Order* order) {
                 
                 if (opposing_order->filled_quantity == opposing_order->quantity) {
                     level->remove_front();
-                    orders_.erase(opposing_order->id);
-                    pool_.deallocate(opposing_order);
+                    release_order(opposing_order);
                 }
             }
             
@@ -175,8 +387,7 @@ void OrderBook::match_limit_order(Order* order) {
                 
                 if (opposing_order->filled_quantity == opposing_order->quantity) {
                     level->remove_front();
-                    orders_.erase(opposing_order->id);
-                    pool_.deallocate(opposing_order);
+                    release_order(opposing_order);
                 }
             }
             
@@ -205,8 +416,7 @@ void OrderBook::match_limit_order(Order* order) {
                 
                 if (opposing_order->filled_quantity == opposing_order->quantity) {
                     level->remove_front();
-                    orders_.erase(opposing_order->id);
-                    pool_.deallocate(opposing_order);
+                    release_order(opposing_order);
                 }
             }
             
@@ -233,6 +443,18 @@ void OrderBook::match_limit_order(Order* order) {
             it->second->add_order(order);
         }
         
+        if (order->account_id != 0) {
+            link_owner(account_orders_, order->account_id, order, &Order::account_link);
+        }
+        if (order->session_id != 0) {
+            link_owner(session_orders_, order->session_id, order, &Order::session_link);
+        }
+        if (order->tif == TimeInForce::DAY) {
+            link_day(order);
+        } else if (order->expire_tick != 0) {
+            timer_wheel_.schedule(order);
+        }
+        
         if (order->filled_quantity > 0) {
             order->status = OrderStatus::PARTIAL_FILL;
         }
@@ -271,20 +493,217 @@ void OrderBook::execute_trade(Order* buy_order, Order* sell_order,
     }
 }
 
+void OrderBook::link_owner(OwnerMap& heads, uint64_t owner, Order* order,
+                           OwnerLink Order::*link) {
+    Order*& head = heads[owner];
+    OwnerLink& links = order->*link;
+    links.prev = nullptr;
+    links.next = head;
+    links.head = &head;
+    if (head) (head->*link).prev = order;
+    head = order;
+}
+
+void OrderBook::unlink_owner(OwnerMap& heads, uint64_t owner, Order* order,
+                             OwnerLink Order::*link) {
+    OwnerLink& links = order->*link;
+    if (links.prev) {
+        (links.prev->*link).next = links.next;
+    } else {
+        *links.head = links.next;
+    }
+    if (links.next) {
+        (links.next->*link).prev = links.prev;
+    } else if (!links.prev) {
+        heads.erase(owner);
+    }
+    links.prev = nullptr;
+    links.next = nullptr;
+    links.head = nullptr;
+}
+
+void OrderBook::link_day(Order* order) {
+    order->timer_prev = nullptr;
+    order->timer_next = day_orders_;
+    if (day_orders_) day_orders_->timer_prev = order;
+    day_orders_ = order;
+}
+
+void OrderBook::unlink_day(Order* order) {
+    if (order->timer_prev) {
+        order->timer_prev->timer_next = order->timer_next;
+    } else {
+        day_orders_ = order->timer_next;
+    }
+    if (order->timer_next) {
+        order->timer_next->timer_prev = order->timer_prev;
+    }
+    order->timer_prev = nullptr;
+    order->timer_next = nullptr;
+}
+
+void OrderBook::remove_from_level(Order* order) {
+    PriceLevel* level = order->level;
+    level->remove_order(order);
+    
+    if (level->is_empty()) {
+        if (order->side == Side::BUY) {
+            bids_.erase(level->price);
+        } else {
+            asks_.erase(level->price);
+        }
+    }
+}
+
+// drops an order that has already left its price level (or never rested).
+// detached names an owner list the caller has already taken apart.
+void OrderBook::release_order(Order* order, OwnerLink Order::*detached) {
+    if (order->level) {
+        if (order->account_id != 0 && detached != &Order::account_link) {
+            unlink_owner(account_orders_, order->account_id, order, &Order::account_link);
+        }
+        if (order->session_id != 0 && detached != &Order::session_link) {
+            unlink_owner(session_orders_, order->session_id, order, &Order::session_link);
+        }
+        if (order->tif == TimeInForce::DAY) {
+            unlink_day(order);
+        } else {
+            timer_wheel_.cancel(order);
+        }
+        order->level = nullptr;
+    }
+    orders_.erase(order->id);
+    pool_.deallocate(order);
+}
+
 bool OrderBook::cancel_order(uint64_t order_id) {
-    auto it = orders_.find(order_id);
-    if (it == orders_.end()) return false;
+    Order* order = orders_.find(order_id);
+    if (!order) return false;
     
-    Order* order = it->second;
     if (order->status == OrderStatus::FILLED) return false;
     
-    order->status = OrderStatus::CANCELLED;
+    if (order->level) {
+        remove_from_level(order);
+    }
+    release_order(order);
     return true;
 }
 
+void OrderBook::set_session_close(std::chrono::nanoseconds close) {
+    session_close_ = close;
+    session_close_tick_ = close.count() > 0
+        ? (static_cast<uint64_t>(close.count()) + TIMER_TICK_NS - 1) / TIMER_TICK_NS
+        : 0;
+}
+
+size_t OrderBook::expire_orders(std::chrono::nanoseconds now) {
+    if (now.count() <= 0) return 0;
+    
+    uint64_t tick = static_cast<uint64_t>(now.count()) / TIMER_TICK_NS;
+    
+    size_t expired = timer_wheel_.advance(tick, [this](Order* order) {
+        remove_from_level(order);
+        release_order(order);
+    });
+    
+    if (session_close_tick_ != 0 && tick >= session_close_tick_) {
+        while (day_orders_) {
+            Order* order = day_orders_;
+            remove_from_level(order);
+            release_order(order);
+            ++expired;
+        }
+    }
+    
+    return expired;
+}
+
+size_t OrderBook::cancel_owner(OwnerMap& heads, uint64_t owner, OwnerLink Order::*link) {
+    auto it = heads.find(owner);
+    if (it == heads.end()) return 0;
+    
+    // detach the whole list up front so each release skips this owner map
+    Order* order = it->second;
+    heads.erase(it);
+    
+    size_t cancelled = 0;
+    while (order) {
+        Order* next = (order->*link).next;
+        
+        // the walk is bound by cache misses, so start fetching the next
+        // order's level neighbours and the order after it early
+        if (next) {
+            Order* ahead = (next->*link).next;
+            if (ahead) prefetch_order(ahead);
+            __builtin_prefetch(next->level_prev);
+            __builtin_prefetch(next->level_next);
+        }
+        
+        remove_from_level(order);
+        release_order(order, link);
+        order = next;
+        ++cancelled;
+    }
+    return cancelled;
+}
+
+size_t OrderBook::mass_cancel(AccountId account) {
+    return cancel_owner(account_orders_, account.value, &Order::account_link);
+}
+
+size_t OrderBook::mass_cancel(SessionId session) {
+    return cancel_owner(session_orders_, session.value, &Order::session_link);
+}
+
+// cancels one side level by level; every order still leaves its owner lists,
+// its timer and the id index, since the other side keeps using them
+size_t OrderBook::cancel_side(Side side) {
+    size_t cancelled = 0;
+    auto cancel_levels = [&](auto& levels) {
+        for (auto& [price, level] : levels) {
+            Order* order = level->get_front();
+            while (order) {
+                Order* next = order->level_next;
+                release_order(order);
+                order = next;
+                ++cancelled;
+            }
+        }
+        levels.clear();
+    };
+    
+    if (side == Side::BUY) {
+        cancel_levels(bids_);
+    } else {
+        cancel_levels(asks_);
+    }
+    return cancelled;
+}
+
+size_t OrderBook::mass_cancel(Side side) {
+    return cancel_side(side);
+}
+
+// nothing survives, so every structure is reset wholesale and the pool takes
+// all orders back at once instead of releasing them one by one. this also
+// drops unfilled market remainders, which never rest but are still tracked.
+size_t OrderBook::mass_cancel() {
+    size_t cancelled = orders_.size();
+    
+    bids_.clear();
+    asks_.clear();
+    account_orders_.clear();
+    session_orders_.clear();
+    day_orders_ = nullptr;
+    timer_wheel_.clear();
+    orders_.clear();
+    pool_.clear();
+    
+    return cancelled;
+}
+
 Order* OrderBook::get_order(uint64_t order_id) {
-    auto it = orders_.find(order_id);
-    return (it != orders_.end()) ? it->second : nullptr;
+    return orders_.find(order_id);
 }
 
 double OrderBook::get_best_bid() const {
@@ -3,7 +3,6 @@
 #include <memory>
 #include <unordered_map>
 #include <map>
-#include <deque>
 #include <string>
 #include <chrono>
 #include <vector>
@@ -27,26 +26,79 @@ enum class OrderStatus {
     CANCELLED
 };
 
-struct Order {
+enum class TimeInForce {
+    GTC,    // good till cancelled
+    DAY,    // expires at the book's session close
+    GTD     // expires at an explicit time
+};
+
+class PriceLevel;
+struct Order;
+
+// separate id types so mass_cancel can be overloaded per owner; 0 means none
+struct AccountId {
+    uint64_t value;
+};
+
+struct SessionId {
+    uint64_t value;
+};
+
+// head points into the owner map's node, which stays put across rehashes,
+// so unlinking a list head never needs a hash lookup
+struct OwnerLink {
+    Order* prev;
+    Order* next;
+    Order** head;
+};
+
+// the fields a cancel or an expiry walks through fill the first two cache
+// lines; the rest is only read when matching or reporting
+struct alignas(64) Order {
+    // intrusive links, only valid while the order rests in the book
     uint64_t id;
-    std::string symbol;
-    Side side;
-    OrderType type;
-    double price;
+    PriceLevel* level;
+    Order* level_prev;
+    Order* level_next;
+    OwnerLink account_link;
     uint64_t quantity;
+    
+    OwnerLink session_link;
+    Order* timer_prev;          // timer wheel slot, or the book's DAY list
+    Order* timer_next;
     uint64_t filled_quantity;
+    uint32_t timer_slot;
+    Side side;
+    TimeInForce tif;
+    
+    OrderType type;
     OrderStatus status;
+    double price;
     std::chrono::nanoseconds timestamp;
+    uint64_t expire_tick;       // timer wheel tick, 0 if the order never expires
+    uint64_t account_id;
+    uint64_t session_id;
     
     Order() = default;
-    Order(uint64_t id_, const std::string& symbol_, Side side_, 
-          OrderType type_, double price_, uint64_t quantity_)
-        : id(id_), symbol(symbol_), side(side_), type(type_), 
-          price(price_), quantity(quantity_), filled_quantity(0),
-          status(OrderStatus::NEW),
-          timestamp(std::chrono::high_resolution_clock::now().time_since_epoch()) {}
+    Order(uint64_t id_, Side side_, OrderType type_, double price_, uint64_t quantity_,
+          uint64_t account_id_ = 0, uint64_t session_id_ = 0,
+          TimeInForce tif_ = TimeInForce::GTC)
+        : id(id_), level(nullptr), level_prev(nullptr), level_next(nullptr),
+          account_link{nullptr, nullptr, nullptr}, quantity(quantity_),
+          session_link{nullptr, nullptr, nullptr},
+          timer_prev(nullptr), timer_next(nullptr), filled_quantity(0),
+          timer_slot(UINT32_MAX), side(side_), tif(tif_),
+          type(type_), status(OrderStatus::NEW), price(price_),
+          timestamp(std::chrono::high_resolution_clock::now().time_since_epoch()),
+          expire_tick(0), account_id(account_id_), session_id(session_id_) {}
 };
 
+// pulls both hot cache lines of an order ahead of a list walk
+inline void prefetch_order(const Order* order) {
+    __builtin_prefetch(order);
+    __builtin_prefetch(reinterpret_cast<const char*>(order) + 64);
+}
+
 struct Trade {
     uint64_t buy_order_id;
     uint64_t sell_order_id;
@@ -72,21 +124,68 @@ public:
     void clear();
 };
 
+// id -> order lookup as an open-addressed robin hood table. ids are handed
+// out sequentially, so the identity hash keeps neighbouring ids in
+// neighbouring entries; erase shifts the probe run back instead of leaving
+// tombstones. capacity follows the peak number of live orders.
+class OrderIndex {
+private:
+    struct Entry {
+        uint64_t id;        // 0 marks an empty entry
+        Order* order;
+    };
+    
+    static constexpr size_t INITIAL_CAPACITY = 1024;
+    static constexpr size_t NOT_FOUND = SIZE_MAX;
+    
+    std::vector<Entry> entries_;
+    size_t mask_;
+    size_t size_;
+    
+    void place(Entry entry);
+    void grow();
+    size_t locate(uint64_t id) const;
+    
+public:
+    OrderIndex();
+    void insert(Order* order);
+    Order* find(uint64_t id) const;
+    void erase(uint64_t id);
+    void clear();
+    size_t size() const { return size_; }
+    
+    template <typename F>
+    void for_each(F&& f) const {
+        for (const Entry& entry : entries_) {
+            if (entry.id != 0) f(entry.order);
+        }
+    }
+};
+
 class PriceLevel {
 public:
     double price;
     uint64_t total_volume;
-    std::deque<Order*> orders;
+    Order* head;
+    Order* tail;
     
-    PriceLevel(double p) : price(p), total_volume(0) {}
+    PriceLevel(double p) : price(p), total_volume(0), head(nullptr), tail(nullptr) {}
     
     void add_order(Order* order) {
-        orders.push_back(order);
+        order->level = this;
+        order->level_prev = tail;
+        order->level_next = nullptr;
+        if (tail) {
+            tail->level_next = order;
+        } else {
+            head = order;
+        }
+        tail = order;
         total_volume += (order->quantity - order->filled_quantity);
     }
     
     Order* get_front() {
-        return orders.empty() ? nullptr : orders.front();
+        return head;
     }
     
     void update_volume_after_fill(uint64_t filled_qty) {
@@ -98,16 +197,117 @@ public:
     }
     
     void remove_front() {
-        if (!orders.empty()) {
-            orders.pop_front();
+        if (head) {
+            unlink(head);
         }
     }
     
+    // removes an order from anywhere in the queue along with its open volume
+    void remove_order(Order* order) {
+        update_volume_after_fill(order->quantity - order->filled_quantity);
+        unlink(order);
+    }
+    
     bool is_empty() const {
-        return orders.empty();
+        return head == nullptr;
     }
+    
+private:
+    void unlink(Order* order) {
+        if (order->level_prev) {
+            order->level_prev->level_next = order->level_next;
+        } else {
+            head = order->level_next;
+        }
+        if (order->level_next) {
+            order->level_next->level_prev = order->level_prev;
+        } else {
+            tail = order->level_prev;
+        }
+        order->level_prev = nullptr;
+        order->level_next = nullptr;
+    }
+};
+
+// hierarchical timing wheel: LEVELS x SLOTS buckets of intrusive order lists.
+// level 0 holds orders due within SLOTS ticks, each higher level covers SLOTS
+// times the span of the one below and is cascaded down as time reaches it.
+// scheduling and cancelling are O(1). per-level occupancy bitmaps let advance
+// jump straight to the next tick that expires or cascades a slot, so it costs
+// O(occupied slots passed + expired) however many ticks have elapsed.
+class TimerWheel {
+private:
+    static constexpr uint32_t SLOT_BITS = 8;
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+    static constexpr uint32_t SLOT_MASK = SLOTS - 1;
+    static constexpr uint32_t LEVELS = 4;
+    static constexpr uint64_t MAX_DELTA = (1ull << (SLOT_BITS * LEVELS)) - 1;
+    static constexpr uint32_t WORDS = SLOTS / 64;
+    
+    std::array<Order*, SLOTS * LEVELS> slots_;
+    std::array<uint64_t, WORDS * LEVELS> occupied_;
+    uint64_t current_tick_;
+    size_t size_;
+    
+    void place(Order* order);
+    void cascade(uint32_t level);
+    Order* take_slot(uint32_t slot);
+    uint64_t next_event_tick() const;
+    
+public:
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+    
+    explicit TimerWheel(uint64_t start_tick);
+    
+    void schedule(Order* order);
+    void cancel(Order* order);
+    void clear();
+    
+    uint64_t current_tick() const { return current_tick_; }
+    size_t size() const { return size_; }
+    
+    // moves the wheel forward to tick and calls on_expire for every order due
+    // at or before it. orders are unlinked from the wheel before the callback
+    // runs, so the callback may release them.
+    template <typename F>
+    size_t advance(uint64_t tick, F&& on_expire);
 };
 
+template <typename F>
+size_t TimerWheel::advance(uint64_t tick, F&& on_expire) {
+    size_t expired = 0;
+    
+    while (current_tick_ < tick) {
+        // ticks before the next event have nothing to cascade or expire
+        uint64_t next = next_event_tick();
+        if (next > tick) {
+            current_tick_ = tick;
+            break;
+        }
+        current_tick_ = next;
+        
+        for (uint32_t level = 1; level < LEVELS; ++level) {
+            if ((current_tick_ >> (SLOT_BITS * (level - 1))) & SLOT_MASK) break;
+            cascade(level);
+        }
+        
+        Order* order = take_slot(current_tick_ & SLOT_MASK);
+        
+        while (order) {
+            Order* next = order->timer_next;
+            order->timer_prev = nullptr;
+            order->timer_next = nullptr;
+            order->timer_slot = NO_SLOT;
+            --size_;
+            ++expired;
+            on_expire(order);
+            order = next;
+        }
+    }
+    
+    return expired;
+}
+
 class OrderBook {
 private:
     std::string symbol_;
@@ -115,7 +315,21 @@ private:
     std::map<double, std::unique_ptr<PriceLevel>, std::greater<double>> bids_;
     std::map<double, std::unique_ptr<PriceLevel>> asks_;
     
-    std::unordered_map<uint64_t, Order*> orders_;
+    OrderIndex orders_;
+    
+    using OwnerMap = std::unordered_map<uint64_t, Order*>;
+    
+    // head of each account's and each session's intrusive list of resting orders
+    OwnerMap account_orders_;
+    OwnerMap session_orders_;
+    
+    TimerWheel timer_wheel_;
+    
+    // DAY orders share one expiry, so they wait on their own list instead of
+    // the wheel and moving the session close never touches them
+    Order* day_orders_;
+    std::chrono::nanoseconds session_close_;
+    uint64_t session_close_tick_;   // 0 while no close is set
     
     OrderPool pool_;
     
@@ -135,14 +349,50 @@ private:
     void execute_trade(Order* buy_order, Order* sell_order, 
                       double price, uint64_t quantity);
     
+    void link_owner(OwnerMap& heads, uint64_t owner, Order* order, OwnerLink Order::*link);
+    void unlink_owner(OwnerMap& heads, uint64_t owner, Order* order, OwnerLink Order::*link);
+    size_t cancel_owner(OwnerMap& heads, uint64_t owner, OwnerLink Order::*link);
+    void link_day(Order* order);
+    void unlink_day(Order* order);
+    void remove_from_level(Order* order);
+    void release_order(Order* order, OwnerLink Order::*detached = nullptr);
+    size_t cancel_side(Side side);
+    
 public:
+    // expiry times are measured on high_resolution_clock, the same clock as
+    // Order::timestamp, and resolved to TIMER_TICK_NS
+    static constexpr uint64_t TIMER_TICK_NS = 1000000;
+    
     OrderBook(const std::string& symbol);
     ~OrderBook();
     
-    uint64_t add_order(Side side, OrderType type, double price, uint64_t quantity);
+    // returns 0 without touching the book if a GTD order has no expire_time,
+    // a DAY order arrives while no session close is set, or a DAY/GTD order
+    // is already expired
+    uint64_t add_order(Side side, OrderType type, double price, uint64_t quantity,
+                       AccountId account = AccountId{0}, SessionId session = SessionId{0},
+                       TimeInForce tif = TimeInForce::GTC,
+                       std::chrono::nanoseconds expire_time = std::chrono::nanoseconds::zero());
     bool cancel_order(uint64_t order_id);
     Order* get_order(uint64_t order_id);
     
+    // DAY orders are only accepted while a close is set and expire at it,
+    // including orders that were resting before it was moved. a non-positive
+    // close clears it; resting DAY orders then wait for the next close.
+    void set_session_close(std::chrono::nanoseconds close);
+    
+    // advances the timer wheel, cancelling every resting order whose expiry is
+    // at or before now. call from the matching thread. returns orders expired;
+    // a non-positive now is ignored.
+    size_t expire_orders(std::chrono::nanoseconds now);
+    
+    // mass cancel resting orders by account, by session (e.g. on disconnect),
+    // by side or all; returns orders cancelled
+    size_t mass_cancel(AccountId account);
+    size_t mass_cancel(SessionId session);
+    size_t mass_cancel(Side side);
+    size_t mass_cancel();
+    
     double get_best_bid() const;
     double get_best_ask() const;
     double get_spread() const;